@@ -0,0 +1,271 @@
+//####### Test module for quantum sync rejection sampler #######################################
+
+//Define Module name
+ #define BOOST_TEST_MODULE "phys/quantum_sync/rejection_sampler"
+
+//Include Boost unit tests library & library for floating point comparison
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+#include <picsar_qed/physics/quantum_sync/quantum_sync_engine_rejection_sampler.hpp>
+#include <picsar_qed/physics/quantum_sync/quantum_sync_engine_tabulated_functions.hpp>
+#include <picsar_qed/physics/quantum_sync/quantum_sync_engine_core.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <utility>
+#include <vector>
+
+//Tolerance for double precision calculations
+const double double_tolerance = 1.0e-7;
+
+//Tolerance for single precision calculations
+const float float_tolerance = 5.0e-4;
+
+//Tolerance for the comparison of cumulative distributions
+const double cdf_tolerance = 0.015;
+
+using namespace picsar::multi_physics::phys::quantum_sync;
+using namespace picsar::multi_physics::phys;
+using namespace picsar::multi_physics::math;
+
+//Templated tolerance
+template <typename T>
+T constexpr tolerance()
+{
+    if(std::is_same<T,float>::value)
+        return float_tolerance;
+    else
+        return double_tolerance;
+}
+
+// ------------- Tests --------------
+
+// ***Test fast evaluation of the Bessel functions
+
+template <typename RealType>
+void check_fast_synchrotron_bessel()
+{
+    const auto cases = std::array<std::pair<double,double>,5>{
+        std::make_pair( 1e-5, 4629.2044114881355),
+        std::make_pair( 1e-4, 995.9088308508012),
+        std::make_pair( 1e-2, 44.497250411420913),
+        std::make_pair( 1.0, 0.651422815355309),
+        std::make_pair( 10.0, 1.9223826430338323e-05)};
+
+    for (const auto& cc : cases)
+    {
+        auto int_k_5_3 = zero<RealType>;
+        auto k_2_3 = zero<RealType>;
+        compute_fast_synchrotron_bessel(
+            static_cast<RealType>(cc.first), int_k_5_3, k_2_3);
+
+        const auto sol_int_k_5_3 = static_cast<RealType>(cc.second);
+        const auto sol_k_2_3 = static_cast<RealType>(
+            k_v(2.0/3.0, cc.first));
+
+        BOOST_CHECK_SMALL((int_k_5_3-sol_int_k_5_3)/sol_int_k_5_3,
+            tolerance<RealType>());
+        BOOST_CHECK_SMALL((k_2_3-sol_k_2_3)/sol_k_2_3,
+            tolerance<RealType>());
+    }
+}
+
+BOOST_AUTO_TEST_CASE( picsar_quantum_sync_fast_synchrotron_bessel)
+{
+    check_fast_synchrotron_bessel<double>();
+    check_fast_synchrotron_bessel<float>();
+}
+
+// *******************************
+
+// ***Test fast evaluation of the emission spectrum
+
+template <typename RealType>
+void check_fast_emission_spectrum()
+{
+    const auto chis = std::array<double,4>{1e-3, 0.1, 10.0, 1000.0};
+    const auto csis = std::array<double,4>{1e-6, 0.01, 0.5, 0.99};
+    const double coeff = sqrt(3.0)/(2.0*pi<double>);
+
+    for (const auto chi : chis){
+        for (const auto csi : csis){
+            const auto sol = compute_G_integrand(chi, csi)/csi/coeff;
+            if(sol < 1e-30) continue;
+
+            const auto res = compute_fast_emission_spectrum(
+                static_cast<RealType>(chi), static_cast<RealType>(csi));
+
+            BOOST_CHECK_SMALL((res-sol)/sol, static_cast<double>(tolerance<RealType>()));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( picsar_quantum_sync_fast_emission_spectrum)
+{
+    check_fast_emission_spectrum<double>();
+    check_fast_emission_spectrum<float>();
+}
+
+// *******************************
+
+// ***Test the analytic majorant
+
+BOOST_AUTO_TEST_CASE( picsar_quantum_sync_rejection_sampler_majorant)
+{
+    const auto cc = rejection_sampler_majorant_coeff<double>;
+    const auto bb = rejection_sampler_majorant_decay<double>;
+
+    for (double log_y = -10.0; log_y < 2.5; log_y += 0.01){
+        const auto yy = pow(10.0, log_y);
+        auto int_k_5_3 = 0.0;
+        auto k_2_3 = 0.0;
+        compute_fast_synchrotron_bessel(yy, int_k_5_3, k_2_3);
+
+        BOOST_CHECK_LE(k_2_3, int_k_5_3);
+        BOOST_CHECK_LE(int_k_5_3, cc*pow(yy, -2.0/3.0)*exp(-bb*yy));
+    }
+}
+
+// *******************************
+
+// ***Test the distribution of the sampled photons
+
+template <typename RealType>
+void check_rejection_sampler_distribution()
+{
+    const auto chis = std::array<double,4>{1e-3, 0.1, 10.0, 1000.0};
+    const auto sampler = photon_emission_rejection_sampler<RealType>{};
+    const int how_many = 20000;
+
+    std::mt19937 gen(18);
+    std::uniform_real_distribution<RealType> unf(
+        zero<RealType>, one<RealType>);
+
+    for (const auto chi : chis){
+        auto res = std::vector<double>(how_many);
+        int tot_trials = 0;
+        for (auto& el : res){
+            int trials = 0;
+            el = sampler.sample(static_cast<RealType>(chi), unf(gen), &trials);
+            tot_trials += trials;
+            BOOST_CHECK(trials >= 1 &&
+                trials <= rejection_sampler_max_trials);
+            BOOST_CHECK(el >= 0.0 && el < chi);
+        }
+
+        const auto acceptance_rate = static_cast<double>(how_many)/tot_trials;
+        BOOST_TEST_MESSAGE("chi_part " << chi <<
+            ": measured acceptance rate " << acceptance_rate);
+        BOOST_CHECK_GE(acceptance_rate, 0.5);
+
+        std::sort(res.begin(), res.end());
+        const auto probs = std::array<double,9>{
+            0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9};
+        auto quantiles = std::vector<double>{};
+        for (const auto pp : probs)
+            quantiles.push_back(res[static_cast<int>(pp*how_many)]);
+
+        const auto cdf = compute_cumulative_prob(chi, quantiles);
+        for (int i = 0; i < static_cast<int>(probs.size()); ++i)
+            BOOST_CHECK_SMALL(cdf[i] - probs[i], cdf_tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( picsar_quantum_sync_rejection_sampler_distribution)
+{
+    check_rejection_sampler_distribution<double>();
+    check_rejection_sampler_distribution<float>();
+}
+
+// *******************************
+
+// ***Test special cases of the rejection sampler
+
+template <typename RealType>
+void check_rejection_sampler_special_cases()
+{
+    const auto sampler = photon_emission_rejection_sampler<RealType>{};
+    const auto unf = static_cast<RealType>(0.3);
+
+    //The result is a deterministic function of its arguments
+    bool is_out = false;
+    const auto chi_1 = sampler.interp(static_cast<RealType>(2.0), unf, &is_out);
+    const auto chi_2 = sampler.interp(static_cast<RealType>(2.0), unf);
+    BOOST_CHECK_EQUAL(chi_1, chi_2);
+    BOOST_CHECK(!is_out);
+
+    //A particle with chi = 0 does not emit
+    BOOST_CHECK_EQUAL(sampler.interp(zero<RealType>, unf), zero<RealType>);
+
+    //Photons below frac_min are disregarded
+    const auto sampler_cut = photon_emission_rejection_sampler<RealType>{
+        static_cast<RealType>(0.5)};
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<RealType> dist(
+        zero<RealType>, one<RealType>);
+    const auto chi_part = static_cast<RealType>(0.1);
+    for (int i = 0; i < 100; ++i){
+        const auto chi_phot = sampler_cut.interp(chi_part, dist(gen));
+        BOOST_CHECK(chi_phot == zero<RealType> ||
+            chi_phot >= static_cast<RealType>(0.5)*chi_part);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( picsar_quantum_sync_rejection_sampler_special_cases)
+{
+    check_rejection_sampler_special_cases<double>();
+    check_rejection_sampler_special_cases<float>();
+}
+
+// *******************************
+
+// ***Test the rejection sampler as a TableType for photon emission
+
+template <typename RealType>
+void check_rejection_sampler_photon_emission()
+{
+    const auto sampler = photon_emission_rejection_sampler<RealType>{};
+
+    const auto chi_part = static_cast<RealType>(1.0);
+    const auto unf = static_cast<RealType>(0.6);
+    const auto me_c = heaviside_lorentz_electron_rest_energy<RealType>;
+    const auto p0 = me_c*vec3<RealType>{
+        static_cast<RealType>(1.0e3),
+        static_cast<RealType>(-2.0e3),
+        static_cast<RealType>(0.5e3)};
+    auto p_part = p0;
+    auto p_phot = vec3<RealType>{};
+
+    const auto is_ok = generate_photon_update_momentum<
+        RealType,
+        photon_emission_rejection_sampler<RealType>,
+        unit_system::heaviside_lorentz>(
+            chi_part, p_part, unf, sampler, p_phot);
+
+    BOOST_CHECK(is_ok);
+
+    const auto chi_phot = sampler.interp(chi_part, unf);
+    BOOST_CHECK(chi_phot > zero<RealType> && chi_phot < chi_part);
+
+    const auto gamma_part = compute_gamma_ele_pos<
+        RealType, unit_system::heaviside_lorentz>(p0);
+    const auto exp_p_phot = p0*((gamma_part - one<RealType>)*
+        (chi_phot/chi_part)*me_c/norm(p0));
+
+    for (int i = 0; i < 3; ++i){
+        BOOST_CHECK_SMALL((p_phot[i]-exp_p_phot[i])/exp_p_phot[i],
+            tolerance<RealType>());
+        BOOST_CHECK_SMALL((p_part[i]+p_phot[i]-p0[i])/p0[i],
+            tolerance<RealType>());
+    }
+}
+
+BOOST_AUTO_TEST_CASE( picsar_quantum_sync_rejection_sampler_photon_emission)
+{
+    check_rejection_sampler_photon_emission<double>();
+    check_rejection_sampler_photon_emission<float>();
+}
+
+// *******************************
@@ -12,6 +12,7 @@
 #include <vector>
 #include <algorithm>
 #include <array>
+#include <random>
 
 //Tolerance for double precision calculations
 const double double_tolerance = 1.0e-3;
@@ -283,6 +284,59 @@ BOOST_AUTO_TEST_CASE( picsar_quantum_sync_photon_emission_table)
 }
 
 
+template <typename RealType, typename VectorType>
+void check_photon_emission_table_batch()
+{
+    auto table = get_em_table<RealType, VectorType>();
+    auto coords = table.get_all_coordinates();
+    auto vals = VectorType(coords.size());
+    std::transform(coords.begin(), coords.end(), vals.begin(),
+        [=](std::array<RealType,2> x){
+            return static_cast<RealType>(1.0*pow(x[1]/x[0], 4.0 + log10(x[0])));});
+    table.set_all_vals(vals);
+
+    //Particles spread over the table (and out of it), particles
+    //in a single cell and particles sharing the same chi
+    auto gen = std::mt19937{12345};
+    auto unf = std::uniform_real_distribution<RealType>{0.0, 1.0};
+    const int how_many_events = 3000;
+    auto chi = std::vector<RealType>(how_many_events);
+    auto rand = std::vector<RealType>(how_many_events);
+    for (int i = 0; i < how_many_events; ++i){
+        if(i < 1000)
+            chi[i] = static_cast<RealType>(chi_min*0.1*pow(1e5, unf(gen)));
+        else if (i < 2000)
+            chi[i] = static_cast<RealType>(2.0 + 0.01*unf(gen));
+        else
+            chi[i] = static_cast<RealType>(0.75);
+        rand[i] = unf(gen);
+    }
+    rand[0] = static_cast<RealType>(0.0);
+    rand[1] = static_cast<RealType>(0.99);
+
+    auto res = std::vector<RealType>(how_many_events);
+    auto flags = std::array<bool, how_many_events>{};
+    table.interp_batch(how_many_events, chi.data(), rand.data(), res.data(), flags.data());
+
+    for (int i = 0; i < how_many_events; ++i){
+        bool flag_out = false;
+        BOOST_CHECK_EQUAL(res[i], table.interp(chi[i], rand[i], &flag_out));
+        BOOST_CHECK_EQUAL(flags[i], flag_out);
+    }
+
+    const auto table_view = table.get_view();
+    auto res_view = std::vector<RealType>(how_many_events);
+    table_view.interp_batch(how_many_events, chi.data(), rand.data(), res_view.data());
+    BOOST_CHECK_EQUAL_COLLECTIONS(res_view.begin(), res_view.end(), res.begin(), res.end());
+}
+
+// ***Test Quantum Synchrotron photon emission table (batched sampling)
+BOOST_AUTO_TEST_CASE( picsar_quantum_sync_photon_emission_table_batch)
+{
+    check_photon_emission_table_batch<double, std::vector<double>>();
+    check_photon_emission_table_batch<float, std::vector<float>>();
+}
+
 template <typename RealType, typename VectorType>
 void check_photon_emission_table_serialization()
 {
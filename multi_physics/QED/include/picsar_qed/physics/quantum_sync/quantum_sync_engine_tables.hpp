@@ -49,6 +49,7 @@ namespace quantum_sync{
     constexpr T default_chi_part_max = static_cast<T>(1.0e3); /* Default maximum particle chi parameter*/
     const int default_chi_part_how_many = 256; /* Default number of grid points for particle chi */
     const int default_frac_how_many = 256; /* Default number of grid points for photon chi */
+    const int interp_batch_block_size = 1024; /* Number of events reordered together by interp_batch */
     template <typename T>
     constexpr T default_frac_min = static_cast<T>(1e-12); /* Default value of the minimum chi_photon fraction */
 
@@ -659,27 +660,144 @@ namespace quantum_sync{
                             log_e_chi_part, i));
                         });
 
-                if(upper_frac_index == 0)
-                    return zero<RealType>;
-
-                if(upper_frac_index ==  m_params.frac_how_many)
-                    return chi_part;
-
-                const auto lower_frac_index = upper_frac_index-1;
-
-                const auto upper_log_frac = m_table.get_y_coord(upper_frac_index);
-                const auto lower_log_frac = m_table.get_y_coord(lower_frac_index);
+                if(upper_frac_index == 0 ||
+                    upper_frac_index ==  m_params.frac_how_many)
+                    return aux_interp_frac(chi_part, log_prob, upper_frac_index,
+                        zero<RealType>, zero<RealType>);
 
                 const auto lower_log_prob= m_table.interp_first_coord
-                    (log_e_chi_part, lower_frac_index);
+                    (log_e_chi_part, upper_frac_index-1);
                 const auto upper_log_prob = m_table.interp_first_coord
                     (log_e_chi_part, upper_frac_index);
 
-                const auto log_frac = utils::linear_interp(
-                    lower_log_prob, upper_log_prob, lower_log_frac, upper_log_frac,
-                    log_prob);
+                return aux_interp_frac(chi_part, log_prob, upper_frac_index,
+                    lower_log_prob, upper_log_prob);
+            }
 
-                return  m_exp(log_frac)*chi_part;
+            /*
+            * Batched version of interp (not designed for GPU usage).
+            * When several particles have a chi parameter in the same cell
+            * of the table (e.g. in a laser focus), interp performs an
+            * independent binary search over almost the same cumulative
+            * probability distribution for each of them. This method groups
+            * the events by cell, orders the random numbers of each group
+            * (with a counting sort on frac_how_many bins) and walks the
+            * distribution once per group, starting each search from the
+            * result of the previous event. The walk is a linear merge if
+            * all the particles of a group have the same chi parameter and
+            * only a few extra steps are needed otherwise, since the
+            * distributions of a cell are close to each other.
+            * Events are processed in blocks of interp_batch_block_size,
+            * so that the reordering stays in cache.
+            * For each event the result is the same as that of interp.
+            *
+            * @param[in] how_many number of events
+            * @param[in] chi_part pointer to the chi parameters of the particles
+            * @param[in] unf_zero_one_minus_epsi pointer to the random numbers uniformly distributed in [0,1)
+            * @param[out] chi_phot pointer to where the chi of the generated photons are stored
+            * @param[out] is_out (optional) pointer to flags set to true if chi_part is out of table
+            */
+            void interp_batch(
+                const int how_many,
+                const RealType* const chi_part,
+                const RealType* const unf_zero_one_minus_epsi,
+                RealType* const chi_phot,
+                bool* const is_out = nullptr) const
+            {
+                using namespace math;
+
+                const auto how_many_x = m_table.get_how_many_x();
+                const auto x_min = m_table.get_x_min();
+                const auto x_size = m_table.get_x_size();
+                const auto frac_how_many = m_params.frac_how_many;
+
+                const auto block_size = std::min(how_many, interp_batch_block_size);
+                auto log_e_chi_part = std::vector<RealType>(block_size);
+                auto log_prob = std::vector<RealType>(block_size);
+                auto cell = std::vector<int>(block_size);
+                auto bin = std::vector<int>(block_size);
+                auto order = std::vector<int>(block_size);
+                auto tmp_order = std::vector<int>(block_size);
+                auto count = std::vector<int>(std::max(how_many_x, frac_how_many) + 1);
+
+                //Stable counting sort of the first n indices of "in" into "out"
+                const auto sort_by = [&count](const std::vector<int>& key,
+                    const int how_many_keys, const int n,
+                    const std::vector<int>& in, std::vector<int>& out){
+                    std::fill(count.begin(), count.begin() + how_many_keys + 1, 0);
+                    for(int k = 0; k < n; ++k) count[key[in[k]]+1]++;
+                    for(int c = 0; c < how_many_keys; ++c) count[c+1] += count[c];
+                    for(int k = 0; k < n; ++k) out[count[key[in[k]]]++] = in[k];
+                };
+
+                for(int start = 0; start < how_many; start += block_size){
+                    const auto n = std::min(block_size, how_many - start);
+                    const auto b_chi_part = chi_part + start;
+                    const auto b_unf = unf_zero_one_minus_epsi + start;
+
+                    for(int i = 0; i < n; ++i){
+                        auto e_chi_part = b_chi_part[i];
+                        if(b_chi_part[i]<m_params.chi_part_min){
+                            e_chi_part = m_params.chi_part_min;
+                            if (is_out != nullptr) is_out[start+i] = true;
+                        }
+                        else if (b_chi_part[i] > m_params.chi_part_max){
+                            e_chi_part = m_params.chi_part_max;
+                            if (is_out != nullptr) is_out[start+i] = true;
+                        }
+                        log_e_chi_part[i] = m_log(e_chi_part);
+                        log_prob[i] = m_log(one<RealType>-b_unf[i]);
+
+                        //Same cell as in equispaced_2d_table::interp_first_coord
+                        auto idx_left = static_cast<int>(
+                            m_floor((how_many_x-1)*(log_e_chi_part[i]-x_min)/x_size));
+                        if (idx_left == (how_many_x-1))
+                            idx_left = how_many_x-2;
+                        cell[i] = idx_left;
+
+                        //log_prob grows as the random number decreases
+                        const auto ibin = static_cast<int>(
+                            (one<RealType>-b_unf[i])*frac_how_many);
+                        bin[i] = std::min(std::max(ibin, 0), frac_how_many-1);
+                        tmp_order[i] = i;
+                    }
+
+                    //By random number bin, then by cell.
+                    //The order only affects the length of the walks.
+                    sort_by(bin, frac_how_many, n, tmp_order, order);
+                    sort_by(cell, how_many_x-1, n, order, tmp_order);
+
+                    auto upper_frac_index = 0;
+                    for(int k = 0; k < n; ++k){
+                        const auto i = tmp_order[k];
+                        if(k == 0 || cell[i] != cell[tmp_order[k-1]])
+                            upper_frac_index = 0;
+
+                        //The distribution of each particle is non-decreasing, so
+                        //moving forward and then backward from the previous result
+                        //gives the same upper bound as the binary search of interp.
+                        //The last values read are those bracketing log_prob.
+                        const auto val = log_prob[i];
+                        auto upper_log_prob = zero<RealType>;
+                        auto lower_log_prob = zero<RealType>;
+                        while(upper_frac_index < frac_how_many){
+                            upper_log_prob = m_table.interp_first_coord(
+                                log_e_chi_part[i], upper_frac_index);
+                            if(val < upper_log_prob) break;
+                            ++upper_frac_index;
+                        }
+                        while(upper_frac_index > 0){
+                            lower_log_prob = m_table.interp_first_coord(
+                                log_e_chi_part[i], upper_frac_index-1);
+                            if(!(val < lower_log_prob)) break;
+                            upper_log_prob = lower_log_prob;
+                            --upper_frac_index;
+                        }
+
+                        chi_phot[start+i] = aux_interp_frac(b_chi_part[i], val,
+                            upper_frac_index, lower_log_prob, upper_log_prob);
+                    }
+                }
             }
 
             /**
@@ -776,6 +894,48 @@ namespace quantum_sync{
             aux_generate_double(RealType x,
                 const std::vector<RealType>& y);
 
+            /*
+            * Auxiliary function used by interp and interp_batch: computes
+            * the chi of the generated photon once the upper bound of
+            * log_prob in the cumulative probability distribution is known.
+            *
+            * @param[in] chi_part the chi parameter of the particle
+            * @param[in] log_prob the log of the probability to be inverted
+            * @param[in] upper_frac_index the upper bound of log_prob
+            * @param[in] lower_log_prob distribution at upper_frac_index-1 (unused if upper_frac_index is 0 or frac_how_many)
+            * @param[in] upper_log_prob distribution at upper_frac_index (unused if upper_frac_index is 0 or frac_how_many)
+            *
+            * @return chi of the generated photon
+            */
+            PXRMP_GPU_QUALIFIER
+            PXRMP_FORCE_INLINE
+            RealType aux_interp_frac(
+                const RealType chi_part,
+                const RealType log_prob,
+                const int upper_frac_index,
+                const RealType lower_log_prob,
+                const RealType upper_log_prob) const noexcept
+            {
+                using namespace math;
+
+                if(upper_frac_index == 0)
+                    return zero<RealType>;
+
+                if(upper_frac_index ==  m_params.frac_how_many)
+                    return chi_part;
+
+                const auto lower_frac_index = upper_frac_index-1;
+
+                const auto upper_log_frac = m_table.get_y_coord(upper_frac_index);
+                const auto lower_log_frac = m_table.get_y_coord(lower_frac_index);
+
+                const auto log_frac = utils::linear_interp(
+                    lower_log_prob, upper_log_prob, lower_log_frac, upper_log_frac,
+                    log_prob);
+
+                return  m_exp(log_frac)*chi_part;
+            }
+
         };
 
         //______________________________________________________________________
@@ -0,0 +1,96 @@
+/* _______________________________________________________________________________________
+
+ *** Copyright Notice ***
+
+ “Particle In Cell Scalable Application Resource (PICSAR) v2”, Copyright (c) 2016,
+ The Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S. Dept. of Energy).
+ All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ NOTICE.
+ This Software was developed under funding from the U.S. Department of Energy
+ and the U.S. Government consequently retains certain rights. As such, the U.S.
+ Government has been granted for itself and others acting on its behalf a paid-up,
+ nonexclusive, irrevocable, worldwide license in the Software to reproduce, distribute
+ copies to the public, prepare derivative works, and perform publicly and display
+ publicly, and to permit other to do so.
+
+_______________________________________________________________________________________ */
+
+/* _______________________________________________________________________________________
+
+   NUMA queries of the bandwidth benchmark (numa_bandwidth.F90)
+
+   NUMA node of the calling thread (getcpu) and NUMA node of the memory pages of an
+   array (move_pages without destination nodes). On other systems than Linux every
+   thread and page is on node 0.
+_______________________________________________________________________________________ */
+
+#include <stdio.h>
+#include <stdint.h>
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#define PXR_NUMA_LINUX 1
+#endif
+
+#define PXR_NUMA_CHUNK 1024
+
+// Number of NUMA nodes of the system
+int pxr_numa_nnodes()
+{
+  int n = 0;
+#ifdef PXR_NUMA_LINUX
+  char path[64];
+  for (;;)
+  {
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", n);
+    if (access(path, F_OK) != 0) break;
+    n++;
+  }
+#endif
+  return n > 0 ? n : 1;
+}
+
+// NUMA node of the CPU running the calling thread
+int pxr_numa_node()
+{
+#if defined(PXR_NUMA_LINUX) && defined(SYS_getcpu)
+  unsigned int cpu, node;
+  if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) return (int) node;
+#endif
+  return 0;
+}
+
+// Add the number of pages of [ptr, ptr+nbytes) located on each node to counts(nnodes),
+// returns 1 if the placement of the pages is not available
+int pxr_numa_count_pages(const void *ptr, long long nbytes, long long *counts, int nnodes)
+{
+#if defined(PXR_NUMA_LINUX) && defined(SYS_move_pages)
+  void *pages[PXR_NUMA_CHUNK];
+  int status[PXR_NUMA_CHUNK];
+  long pagesize = sysconf(_SC_PAGESIZE);
+  uintptr_t p = (uintptr_t) ptr & ~((uintptr_t) pagesize - 1);
+  uintptr_t pend = (uintptr_t) ptr + (uintptr_t) nbytes;
+  long i, n;
+  while (p < pend)
+  {
+    for (n = 0; n < PXR_NUMA_CHUNK && p < pend; n++, p += pagesize) pages[n] = (void *) p;
+    if (syscall(SYS_move_pages, 0, n, pages, NULL, status, 0) != 0) return 1;
+    for (i = 0; i < n; i++)
+    {
+      if (status[i] >= 0 && status[i] < nnodes) counts[status[i]]++;
+    }
+  }
+  return 0;
+#else
+  (void) ptr;
+  (void) nbytes;
+  (void) counts;
+  (void) nnodes;
+  return 1;
+#endif
+}
@@ -0,0 +1,375 @@
+/* _______________________________________________________________________________________
+
+ *** Copyright Notice ***
+
+ “Particle In Cell Scalable Application Resource (PICSAR) v2”, Copyright (c) 2016,
+ The Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S. Dept. of Energy).
+ All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ NOTICE.
+ This Software was developed under funding from the U.S. Department of Energy
+ and the U.S. Government consequently retains certain rights. As such, the U.S.
+ Government has been granted for itself and others acting on its behalf a paid-up,
+ nonexclusive, irrevocable, worldwide license in the Software to reproduce, distribute
+ copies to the public, prepare derivative works, and perform publicly and display
+ publicly, and to permit other to do so.
+
+_______________________________________________________________________________________ */
+
+/* _______________________________________________________________________________________
+
+   Region tracing
+
+   Nested named regions are timed on each OpenMP thread and stored in a ring buffer per
+   thread (the oldest regions are overwritten when the buffer is full). The cycles and
+   instructions of each region can be counted with perf_event_open on Linux. The regions
+   are exported in the Chrome trace format (chrome://tracing, Perfetto), one file per
+   MPI process.
+_______________________________________________________________________________________ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define PXR_TRACE_PERF 1
+#endif
+
+#define PXR_TRACE_MAX_DEPTH 64
+#define PXR_TRACE_MAX_NAMES 1024
+#define PXR_TRACE_NAME_LENGTH 64
+#define PXR_TRACE_HASH_SIZE 2048
+#define PXR_TRACE_NCOUNTERS 2
+
+typedef struct
+{
+  int name;
+  int depth;
+  double t0;
+  double t1;
+  long long counters[PXR_TRACE_NCOUNTERS];
+} pxr_trace_region;
+
+typedef struct
+{
+  pxr_trace_region *regions;
+  long long nrecorded;
+  int depth;
+  pxr_trace_region stack[PXR_TRACE_MAX_DEPTH];
+  int counters_state;
+  int fd[PXR_TRACE_NCOUNTERS];
+} pxr_trace_thread;
+
+static pxr_trace_thread *trace_threads = NULL;
+static int trace_nthreads = 0;
+static int trace_capacity = 0;
+static int trace_hwc = 0;
+static int trace_rank = 0;
+static struct timespec trace_origin;
+static char trace_names[PXR_TRACE_MAX_NAMES][PXR_TRACE_NAME_LENGTH];
+static int trace_nnames = 0;
+// Open addressing hash table of the names: index+1 in trace_names, 0 for an empty slot
+static int trace_hash[PXR_TRACE_HASH_SIZE];
+static const char *trace_counter_names[PXR_TRACE_NCOUNTERS] = {"cycles", "instructions"};
+
+// Time since pxr_trace_init in microseconds
+static double trace_now()
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (t.tv_sec - trace_origin.tv_sec)*1e6 + (t.tv_nsec - trace_origin.tv_nsec)*1e-3;
+}
+
+static pxr_trace_thread * trace_current_thread()
+{
+  int tid = 0;
+#ifdef _OPENMP
+  tid = omp_get_thread_num();
+#endif
+  if (trace_threads == NULL || tid >= trace_nthreads) return NULL;
+  return &trace_threads[tid];
+}
+
+// FNV-1a hash of a region name
+static unsigned int trace_name_hash(const char *name, int length)
+{
+  int i;
+  unsigned int h = 2166136261u;
+  for (i = 0; i < length; i++)
+  {
+    h ^= (unsigned char) name[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// Probe the hash table for a name, returns its index or -1 and the first empty slot
+// (-1 if the table is full). A slot is published once its name is written, so the
+// table is probed without lock.
+static int trace_name_find(const char *name, int length, unsigned int h, int *slot)
+{
+  int k, s, entry;
+  for (k = 0; k < PXR_TRACE_HASH_SIZE; k++)
+  {
+    s = (h + k) & (PXR_TRACE_HASH_SIZE-1);
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+    entry = trace_hash[s];
+    if (entry == 0)
+    {
+      *slot = s;
+      return -1;
+    }
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+    if (strncmp(trace_names[entry-1], name, length) == 0 &&
+      trace_names[entry-1][length] == '\0') return entry-1;
+  }
+  *slot = -1;
+  return -1;
+}
+
+// Index of a region name, added to the table at its first use
+static int trace_name_index(const char *name, int length)
+{
+  int index, slot;
+  unsigned int h;
+  if (length > PXR_TRACE_NAME_LENGTH-1) length = PXR_TRACE_NAME_LENGTH-1;
+  h = trace_name_hash(name, length);
+  index = trace_name_find(name, length, h, &slot);
+  if (index >= 0) return index;
+  // Only the first use of a name is serialized, the table is probed again in case
+  // another thread added it meanwhile
+#ifdef _OPENMP
+#pragma omp critical(pxr_trace_names)
+#endif
+  {
+    index = trace_name_find(name, length, h, &slot);
+    if (index < 0 && slot >= 0 && trace_nnames < PXR_TRACE_MAX_NAMES)
+    {
+      memcpy(trace_names[trace_nnames], name, length);
+      trace_names[trace_nnames][length] = '\0';
+      index = trace_nnames++;
+#ifdef _OPENMP
+#pragma omp flush
+#pragma omp atomic write
+#endif
+      trace_hash[slot] = index+1;
+    }
+  }
+  return index;
+}
+
+// Hardware counters of the calling thread, opened at its first region
+static void trace_open_counters(pxr_trace_thread *t)
+{
+  int i;
+  t->counters_state = -1;
+#ifdef PXR_TRACE_PERF
+  {
+    const unsigned long long configs[PXR_TRACE_NCOUNTERS] =
+      {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS};
+    struct perf_event_attr attr;
+    for (i = 0; i < PXR_TRACE_NCOUNTERS; i++)
+    {
+      memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = configs[i];
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      t->fd[i] = (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+      if (t->fd[i] < 0)
+      {
+        while (--i >= 0) close(t->fd[i]);
+        return;
+      }
+    }
+    t->counters_state = 1;
+  }
+#endif
+  for (i = 0; i < PXR_TRACE_NCOUNTERS; i++) if (t->counters_state < 0) t->fd[i] = -1;
+}
+
+static void trace_read_counters(pxr_trace_thread *t, long long *values)
+{
+  int i;
+  if (trace_hwc && t->counters_state == 0) trace_open_counters(t);
+  for (i = 0; i < PXR_TRACE_NCOUNTERS; i++)
+  {
+    values[i] = -1;
+#ifdef PXR_TRACE_PERF
+    if (trace_hwc && t->counters_state > 0)
+    {
+      if (read(t->fd[i], &values[i], sizeof(long long)) != sizeof(long long)) values[i] = -1;
+    }
+#endif
+  }
+}
+
+static void trace_write_string(FILE *f, const char *s)
+{
+  fputc('"', f);
+  for (; *s; s++)
+  {
+    if (*s == '"' || *s == '\\') fputc('\\', f);
+    if ((unsigned char) *s >= 32) fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+/* _______________________________________________________________________________________
+
+   Fortran interface (see trace_fortran.F90)
+_______________________________________________________________________________________ */
+
+// Allocate the ring buffers of nthreads threads with capacity regions each
+void pxr_trace_init(int rank, int nthreads, int capacity, int hwc)
+{
+  int i;
+  if (trace_threads != NULL || nthreads < 1 || capacity < 1) return;
+  trace_threads = (pxr_trace_thread *) calloc(nthreads, sizeof(pxr_trace_thread));
+  if (trace_threads == NULL) return;
+  for (i = 0; i < nthreads; i++)
+  {
+    trace_threads[i].regions = (pxr_trace_region *) malloc(capacity*sizeof(pxr_trace_region));
+    if (trace_threads[i].regions == NULL)
+    {
+      while (--i >= 0) free(trace_threads[i].regions);
+      free(trace_threads);
+      trace_threads = NULL;
+      return;
+    }
+  }
+  trace_nthreads = nthreads;
+  trace_capacity = capacity;
+  trace_hwc = hwc;
+  trace_rank = rank;
+  clock_gettime(CLOCK_MONOTONIC, &trace_origin);
+}
+
+// Open a region on the calling thread
+void pxr_trace_begin(const char *name, int length)
+{
+  pxr_trace_region *r;
+  pxr_trace_thread *t = trace_current_thread();
+  if (t == NULL) return;
+  // Regions deeper than the stack are only counted to keep begin/end pairs matched
+  if (t->depth >= PXR_TRACE_MAX_DEPTH)
+  {
+    t->depth++;
+    return;
+  }
+  r = &t->stack[t->depth];
+  r->name = trace_name_index(name, length);
+  r->depth = t->depth;
+  t->depth++;
+  trace_read_counters(t, r->counters);
+  r->t0 = trace_now();
+}
+
+// Close the last region opened on the calling thread
+void pxr_trace_end()
+{
+  int i;
+  long long counters[PXR_TRACE_NCOUNTERS];
+  pxr_trace_region *r;
+  double t1 = trace_now();
+  pxr_trace_thread *t = trace_current_thread();
+  if (t == NULL || t->depth == 0) return;
+  t->depth--;
+  if (t->depth >= PXR_TRACE_MAX_DEPTH) return;
+  r = &t->stack[t->depth];
+  r->t1 = t1;
+  trace_read_counters(t, counters);
+  for (i = 0; i < PXR_TRACE_NCOUNTERS; i++)
+  {
+    if (r->counters[i] >= 0 && counters[i] >= 0) r->counters[i] = counters[i] - r->counters[i];
+    else r->counters[i] = -1;
+  }
+  if (r->name >= 0) t->regions[t->nrecorded++ % trace_capacity] = *r;
+}
+
+// Write the regions of all threads in the Chrome trace format, returns 0 on success
+int pxr_trace_write(const char *filename, int length)
+{
+  char fname[1024];
+  FILE *f;
+  int it, i;
+  long long ir, ibeg, ndropped = 0;
+  pxr_trace_thread *t;
+  pxr_trace_region *r;
+
+  if (trace_threads == NULL) return 0;
+  if (length > 1023) length = 1023;
+  memcpy(fname, filename, length);
+  fname[length] = '\0';
+  f = fopen(fname, "w");
+  if (f == NULL) return 1;
+
+  fprintf(f, "{\"traceEvents\":[\n");
+  fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+    "\"args\":{\"name\":\"rank %d\"}}", trace_rank, trace_rank);
+  for (it = 0; it < trace_nthreads; it++)
+  {
+    t = &trace_threads[it];
+    if (t->nrecorded == 0) continue;
+    fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+      "\"args\":{\"name\":\"thread %d\"}}", trace_rank, it, it);
+    ibeg = t->nrecorded > trace_capacity ? t->nrecorded - trace_capacity : 0;
+    ndropped += ibeg;
+    for (ir = ibeg; ir < t->nrecorded; ir++)
+    {
+      r = &t->regions[ir % trace_capacity];
+      fprintf(f, ",\n{\"name\":");
+      trace_write_string(f, trace_names[r->name]);
+      fprintf(f, ",\"cat\":\"picsar\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,"
+        "\"dur\":%.3f,\"args\":{\"depth\":%d", trace_rank, it, r->t0, r->t1 - r->t0,
+        r->depth);
+      for (i = 0; i < PXR_TRACE_NCOUNTERS; i++)
+      {
+        if (r->counters[i] >= 0)
+          fprintf(f, ",\"%s\":%lld", trace_counter_names[i], r->counters[i]);
+      }
+      fprintf(f, "}}");
+    }
+  }
+  fprintf(f, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_regions\":%lld}}\n",
+    ndropped);
+  return fclose(f) == 0 ? 0 : 1;
+}
+
+// Release the ring buffers and the hardware counters
+void pxr_trace_finalize()
+{
+  int it;
+  if (trace_threads == NULL) return;
+  for (it = 0; it < trace_nthreads; it++)
+  {
+#ifdef PXR_TRACE_PERF
+    int i;
+    if (trace_threads[it].counters_state > 0)
+    {
+      for (i = 0; i < PXR_TRACE_NCOUNTERS; i++) close(trace_threads[it].fd[i]);
+    }
+#endif
+    free(trace_threads[it].regions);
+  }
+  free(trace_threads);
+  trace_threads = NULL;
+  trace_nthreads = 0;
+  trace_nnames = 0;
+  memset(trace_hash, 0, sizeof(trace_hash));
+}
@@ -244,6 +244,7 @@ listfiles=["modules/modules.F90", \
            "boundary_conditions/field_boundaries.F90", \
            "boundary_conditions/particle_boundaries.F90", \
            "ios/simple_io.F90", \
+           "ios/checkpoint.F90", \
            "particle_deposition/charge_deposition/charge_deposition_2d.F90", \
            "particle_deposition/charge_deposition/charge_deposition_3d.F90", \
            "particle_deposition/charge_deposition/charge_deposition_manager.F90", \
@@ -251,7 +252,8 @@ listfiles=["modules/modules.F90", \
            "submain.F90", \
            "parallelization/mpi/mpi_routines.F90",\
            "initialization/control_file.F90", \
-           "housekeeping/load_balancing.F90"]
+           "housekeeping/load_balancing.F90", \
+           "housekeeping/autotuning.F90"]
 
 for file in listfiles: 
     justify_file(file,file)
@@ -429,7 +429,8 @@ class MiniAppParser( object ):
 
 
         diag_modules=["diagnostics", \
-                      "simple_io" ]
+                      "simple_io", \
+                      "charge_deposition_kernels" ]
 
         diag_routines=[
                         "calc_diags",\
@@ -441,19 +442,25 @@ class MiniAppParser( object ):
                         "get_loc_kinetic_energy",\
                         "get_kinetic_energy",\
                         "get_loc_norm_2",\
+                        "get_loc_norm_divErho",\
+                        "get_loc_kinetic_energies",\
+                        "get_loc_field_diags",\
                         "system",\
                         "get_norm_divErho",\
                         "output_routines",\
+                        "start_temporal_diagnostics",\
                         "output_temporal_diagnostics",\
                         "write_3d_field_array_to_file",\
                         "write_single_array_to_file",\
                         "write_particles_to_file",\
                         "get_particles_to_dump",\
-                        "concatenate_particle_variable",\
-                        "write_particle_variable",\
+                        "get_particle_tile_offsets",\
+                        "pack_particle_dump",\
+                        "write_particle_dump",\
                         "output_time_statistics",\
                         "final_output_time_statistics",\
                         "pxrdepose_rho_on_grid",\
+                        "depose_rho",\
                         ]
 
         diag_routines_3D=[
@@ -471,6 +478,7 @@ class MiniAppParser( object ):
                         "setup_communicator",\
                         "mpi_initialise",\
                         "compute_simulation_axis",\
+                        "compute_particle_domain_bounds",\
                         "allocate_grid_quantities",\
                         "mpi_close",\
                         "time_statistics",\
@@ -485,6 +493,9 @@ class MiniAppParser( object ):
                         "init_tile_arrays",\
                         "init_tile_arrays_for_species",\
                         "load_particles",\
+                        "load_particles_reproducible",\
+                        "set_qed_particle_ids",\
+                        "threefry_2x32",\
                         "resize_particle_arrays",\
                         "resize_1D_array_real",\
                         "resize_2D_array_real",\
@@ -505,6 +516,7 @@ class MiniAppParser( object ):
                         "read_plasma_section",\
                         "read_solver_section",\
                         "read_sorting_section",\
+                        "read_mesh_refinement_section",\
                         "read_timestat_section",\
                         "read_main_section",\
                         "read_species_section",\
@@ -606,6 +618,7 @@ class MiniAppParser( object ):
 
         generic_routines_3d = [
                         "add_particle_to_species",\
+                        "get_particle_tile_index",\
                         "add_particle_at_tile",\
                         "rm_particles_from_species",\
                         "rm_particle_at_tile",\
@@ -658,6 +671,7 @@ class MiniAppParser( object ):
                         "particle_bcs",\
                         "particle_bcs_tiles",\
                         "particle_bcs_tiles_openmp",\
+                        "particle_bcs_tiles_outbox",\
 #                        "particle_bsc_openmp_reordering",\ not used
                         "particle_bcs_mpi_blocking",\
                         "particle_bcs_mpi_non_blocking",\
@@ -671,6 +685,11 @@ class MiniAppParser( object ):
                         "field_gathering_plus_particle_pusher_1_1_1",\
                         "field_gathering_plus_particle_pusher_2_2_2",\
                         "field_gathering_plus_particle_pusher_3_3_3",\
+                        "field_gathering_plus_particle_pusher_rr",\
+                        "field_gathering_plus_particle_pusher_qed",\
+                        "field_gathering_plus_particle_pusher_mr",\
+                        "copy_old_gather_fields",\
+                        "pxr_pushxyz_flag_tile_leavers",\
                         "particle_bcs_tiles_and_mpi_3d",\
                             ]
 
@@ -692,6 +711,8 @@ class MiniAppParser( object ):
         boris_routines_scalar_3d = [
                         "pxr_boris_push_u_3d",\
                         "pxr_pushxyz",\
+                        "pxr_pushxyz_flag_leavers",\
+                        "pxr_qs_optical_depth_3d",\
                         "pxr_epush_v",\
                         "pxr_bpush_v",\
                         "pxr_set_gamma"]
@@ -769,7 +790,14 @@ class MiniAppParser( object ):
                         "depose_jxjyjz",\
                         "depose_jxjyjz_generic",\
                         "pxrdepose_currents_on_grid_jxjyjz",\
+                        "pxrdepose_currents_species_on_grid",\
+                        "add_held_current",\
+                        "check_held_currents",\
+                        "pxrdepose_currents_mr_patch",\
+                        "restrict_mr_current",\
                         "pxrdepose_currents_on_grid_jxjyjz_classical_sub_seq",
+                        "pxrdepose_currents_rho_on_grid_jxjyjz",
+                        "pxrdepose_currents_rho_on_grid_jxjyjz_sub_openmp",
                         ]
 
         depos_generic_routines_current_2d = [
@@ -967,6 +995,7 @@ class MiniAppParser( object ):
                         "fourier_psaotd",\
                         "fftw3_fortran",\
                         "mpi_fftw3",\
+                        "fft_pipeline",\
                         "fastfft",\
                         "matrix_data",\
                         "matrix_coefficients",\
@@ -977,6 +1006,7 @@ class MiniAppParser( object ):
         spectral_routines  = [
                         "get_non_periodic_mpi_bcs",
                         "setup_groups",
+                        "tune_fft_groups",
                         "adjust_grid_mpi_global",
                         "mpi_minimal_init_fftw",
                         "sendrecv_l2g_generalized",
@@ -1066,6 +1096,18 @@ class MiniAppParser( object ):
                         "dfftw_plan_dft_c2r_3d",
                         "fftw_mpi_init fftw_mpi_plan_dft_r2c_3d",
                         "fftw_mpi_plan_dft_c2r_3d",
+                        "init_fft_pipeline",
+                        "get_pipeline_chunk",
+                        "fft_forward_r2c_pipelined",
+                        "fft_backward_c2r_pipelined",
+                        "fft_pipeline_r2c",
+                        "fft_pipeline_c2r",
+                        "fast_fftw_create_plan_many_r2c_2d_dft",
+                        "fast_fftw_create_plan_many_c2r_2d_dft",
+                        "fast_fftw_create_plan_many_1d_dft",
+                        "dfftw_plan_many_dft",
+                        "dfftw_plan_many_dft_r2c",
+                        "dfftw_plan_many_dft_c2r",
                                ]
 
         fdtd_modules = []
@@ -1073,6 +1115,16 @@ class MiniAppParser( object ):
         fdtd_routines = [
                         "push_bfield",
                         "push_efield",
+                        "push_bfield_pml_slabs",
+                        "push_efield_pml_slabs",
+                        "init_pml_slabs",
+                        "init_pml_slab_fields",
+                        "save_mr_coarse_fields",
+                        "push_mr_patch",
+                        "push_bfield_mr_patch",
+                        "push_efield_mr_patch",
+                        "interpolate_mr_patch_guards",
+                        "init_mr_patch",
                         "init_stencil_coefficients",
                         "FD_weights"
                         ]
@@ -1083,14 +1135,18 @@ class MiniAppParser( object ):
                         "pxrpush_em2d_evec_norder",
                         "pxrpush_em2d_evec",
                         "pxrpush_em2d_bvec_norder",
-                        "pxrpush_em2d_bvec"
+                        "pxrpush_em2d_bvec",
+                        "pxrpush_em2d_evec_pml",
+                        "pxrpush_em2d_bvec_pml"
                            ]
 
         fdtd_routines_3d = [
                         "pxrpush_em3d_evec_norder",
                         "pxrpush_em3d_evec",
                         "pxrpush_em3d_bvec_norder",
-                        "pxrpush_em3d_bvec"
+                        "pxrpush_em3d_bvec",
+                        "pxrpush_em3d_evec_pml",
+                        "pxrpush_em3d_bvec_pml"
                            ]
 
         self.list_available_modules = generic_modules                        \